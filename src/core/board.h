@@ -4,6 +4,12 @@
 #include <ostream>
 #include <istream>
 #include <optional>
+#include <algorithm>
+#include <string>
+#include <limits>
+#include <stdexcept>
+#include <assert.h>
+#include "parallel.h"
 
 namespace game_of_life {
 
@@ -25,6 +31,14 @@ private:
   std::vector<size_t> _occupied_cells_count_by_row;
   std::vector<size_t> _occupied_cells_count_by_col;
   static const CellT _EMPTY_CELL;
+  static constexpr size_t _SAVE_BATCH_SIZE = 1 << 23;
+  // minimal number of cells worth processing on a separate thread
+  static constexpr size_t _MIN_CHUNK_SIZE = 1 << 16;
+
+  /// @brief Get number of blocks of block_size cells necessary to cover cells_count cells.
+  static size_t getBlocksCount(size_t cells_count, size_t block_size) {
+    return cells_count == 0 ? 0 : (cells_count - 1) / block_size + 1;
+  }
 public:
   /// @brief Construct zero-size board
   Board() {}
@@ -94,17 +108,109 @@ public:
     if (length() == 0) reset(); // remove 0-length rows
   }
 
-  /// @brief Write board area delimited by bounding_rect to specified stream. No boundary checks are performed
-  /// @tparam CellEncoder callable with signature "char CellEncoder(CellT)"", encoding cell into a char
+  /// @brief Write board area delimited by bounding_rect to specified stream. Cells outside of the board are written as default-constructed.
+  /// Rows are encoded on multiple threads into a buffer, which is written to the stream in batches of up to _SAVE_BATCH_SIZE bytes.
+  /// @tparam CellEncoder callable with signature "char CellEncoder(CellT)"", encoding cell into a char.
+  /// Should be safe to call concurrently and always return the same char for equal cells. Exceptions thrown by it are propagated to the caller,
+  /// in which case only a part of the area might have been written
   template<class CellEncoder>
   void save(std::ostream& os, const Rectangle& bounding_rect, CellEncoder cell_encoder, char row_separator = '\n') const {
-    for (size_t y = bounding_rect.top; y < bounding_rect.bottom; y++) {
-      for (size_t x = bounding_rect.left; x < bounding_rect.right; x++) {
-        char c = cell_encoder(getCell(x, y));
-        os.write(&c, 1);
+    if (bounding_rect.height() == 0) return;
+    const char empty_cell_char = cell_encoder(_EMPTY_CELL);
+    size_t row_size = bounding_rect.length() + 1;
+    // columns [left, inner_right) are on the board, the rest are written as empty cells
+    size_t inner_right = std::max(std::min(bounding_rect.right, length()), bounding_rect.left);
+    size_t rows_per_batch = std::max<size_t>(_SAVE_BATCH_SIZE / row_size, 1);
+    size_t min_rows_per_thread = std::max<size_t>(_MIN_CHUNK_SIZE / row_size, 1);
+    std::vector<char> buffer(std::min(rows_per_batch, bounding_rect.height()) * row_size);
+
+    for (size_t batch_top = bounding_rect.top; batch_top < bounding_rect.bottom; batch_top += rows_per_batch) {
+      size_t batch_bottom = std::min(batch_top + rows_per_batch, bounding_rect.bottom);
+      parallelFor(batch_top, batch_bottom, min_rows_per_thread, [&] (size_t row_begin, size_t row_end) {
+        for (size_t y = row_begin; y < row_end; y++) {
+          char* out = buffer.data() + (y - batch_top) * row_size;
+          size_t x = bounding_rect.left;
+          // the encoder is called only for occupied cells of occupied rows, everything else is filled with empty_cell_char
+          if (y < height() && _occupied_cells_count_by_row[y] > 0) {
+            const CellT* row = _cells.data() + y * length();
+            for (; x < inner_right; x++) {
+              *out++ = row[x] == _EMPTY_CELL ? empty_cell_char : cell_encoder(row[x]);
+            }
+          }
+          out = std::fill_n(out, bounding_rect.left + bounding_rect.length() - x, empty_cell_char);
+          *out = row_separator;
+        }
+      });
+      os.write(buffer.data(), (batch_bottom - batch_top) * row_size);
+    }
+  }
+
+  /// @brief Count non-default constructed cells in every block_size x block_size block of the board area delimited by bounding_rect.
+  /// Blocks are returned in row-major order, blocks on the right and bottom edges of the area may be partial. No boundary checks are performed.
+  std::vector<size_t> getOccupiedCellsCountByBlock(const Rectangle& bounding_rect, size_t block_size) const {
+    assert(block_size > 0);
+    size_t blocks_per_row = getBlocksCount(bounding_rect.length(), block_size);
+    size_t blocks_per_col = getBlocksCount(bounding_rect.height(), block_size);
+    std::vector<size_t> counts(blocks_per_row * blocks_per_col, 0);
+
+    // block columns without any occupied cells are never scanned
+    std::vector<bool> is_block_col_occupied(blocks_per_row, false);
+    for (size_t x = bounding_rect.left; x < bounding_rect.right; x++) {
+      if (_occupied_cells_count_by_col[x] > 0) is_block_col_occupied[(x - bounding_rect.left) / block_size] = true;
+    }
+
+    // every block row is written by a single thread only
+    size_t block_row_size = std::max<size_t>(std::min(block_size, bounding_rect.height()) * bounding_rect.length(), 1);
+    size_t min_block_rows_per_thread = std::max<size_t>(_MIN_CHUNK_SIZE / block_row_size, 1);
+    parallelFor(0, blocks_per_col, min_block_rows_per_thread, [&] (size_t block_row_begin, size_t block_row_end) {
+      for (size_t block_y = block_row_begin; block_y < block_row_end; block_y++) {
+        size_t* block_row_counts = counts.data() + block_y * blocks_per_row;
+        size_t top = bounding_rect.top + block_y * block_size;
+        size_t bottom = top + std::min(block_size, bounding_rect.bottom - top);
+        for (size_t y = top; y < bottom; y++) {
+          if (_occupied_cells_count_by_row[y] == 0) continue;
+          const CellT* row = _cells.data() + y * length();
+          for (size_t block_x = 0; block_x < blocks_per_row; block_x++) {
+            if (!is_block_col_occupied[block_x]) continue;
+            size_t left = bounding_rect.left + block_x * block_size;
+            size_t right = left + std::min(block_size, bounding_rect.right - left);
+            size_t count = 0;
+            for (size_t x = left; x < right; x++) {
+              if (row[x] != _EMPTY_CELL) count++;
+            }
+            block_row_counts[block_x] += count;
+          }
+        }
+      }
+    });
+    return counts;
+  }
+
+  /// @brief Write density map of the board area delimited by bounding_rect to specified stream as a binary grayscale PGM image.
+  /// Every pixel represents block_size x block_size block of cells, its brightness is proportional to the share of non-default constructed cells in the block.
+  /// Empty area is written as a single black pixel, since most image readers reject zero-size images. No boundary checks are performed
+  void saveDensityMap(std::ostream& os, const Rectangle& bounding_rect, size_t block_size) const {
+    assert(block_size > 0);
+    if (bounding_rect.length() == 0 || bounding_rect.height() == 0) {
+      os.write("P5\n1 1\n255\n\0", 12);
+      return;
+    }
+    size_t blocks_per_row = getBlocksCount(bounding_rect.length(), block_size);
+    size_t blocks_per_col = getBlocksCount(bounding_rect.height(), block_size);
+    auto counts = getOccupiedCellsCountByBlock(bounding_rect, block_size);
+
+    std::vector<unsigned char> pixels(counts.size());
+    for (size_t block_y = 0; block_y < blocks_per_col; block_y++) {
+      size_t block_height = std::min(block_size, bounding_rect.height() - block_y * block_size);
+      for (size_t block_x = 0; block_x < blocks_per_row; block_x++) {
+        size_t block_length = std::min(block_size, bounding_rect.length() - block_x * block_size);
+        size_t idx = block_x + block_y * blocks_per_row;
+        pixels[idx] = static_cast<unsigned char>(counts[idx] * 255 / (block_length * block_height));
       }
-      os.write(&row_separator, 1);
     }
+    std::string header = "P5\n" + std::to_string(blocks_per_row) + " " + std::to_string(blocks_per_col) + "\n255\n";
+    os.write(header.data(), header.size());
+    os.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
   }
 
   /// @brief Replace cell at position specified by newCell with the state specified by cell_description. 
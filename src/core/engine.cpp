@@ -1,4 +1,6 @@
 #include <exception>
+#include <filesystem>
+#include <fstream>
 #include <assert.h>
 #include "engine.h"
 
@@ -7,7 +9,7 @@ namespace game_of_life {
 CellEncoding::CellEncoding(char alive_cell /*= '*'*/, char dead_cell /*= '_'*/) 
   :_alive_cell(alive_cell), _dead_cell(dead_cell) {
   if (alive_cell == dead_cell) {
-    throw std::runtime_error("CellEncoding::CellEncoding: alive and dead cells are represented by the same character: " + alive_cell);
+    throw std::runtime_error(std::string("CellEncoding::CellEncoding: alive and dead cells are represented by the same character: ") + alive_cell);
   }
 }
 
@@ -20,12 +22,30 @@ char CellEncoding::encode(CellState cell) const {
 CellState CellEncoding::decode(char encoded_cell) const {
   if (encoded_cell == _alive_cell) return CellState::ALIVE;
   if (encoded_cell == _dead_cell) return CellState::DEAD;
-  throw std::runtime_error("CellState::decode: unsupported character: " + encoded_cell);
+  throw std::runtime_error(std::string("CellState::decode: unsupported character: ") + encoded_cell);
 }
 
 
 
 
+GameBoard loadGameBoardFromFile(const std::string& path, const CellEncoding& encoding /*= CellEncoding()*/) {
+  if (!std::filesystem::exists(path) || std::filesystem::is_directory(path)) {
+    throw std::runtime_error(path + " is not a valid path to an input file");
+  }
+  std::ifstream input_file(path, std::ios::in | std::ios::binary);
+  if (!input_file) {
+    throw std::runtime_error(path + " can not be opened for reading");
+  }
+  GameBoard board;
+  auto decode = [&encoding] (char c) { return encoding.decode(c); };
+  board.load(input_file, decode);
+  if (input_file.bad() || (input_file.fail() && !input_file.eof())) {
+    throw std::runtime_error("failed to read " + path);
+  }
+  return board;
+}
+
+
 Engine::Engine(GameBoard board, GameRules rules)   
   :_rules(std::move(rules)), _current_board_idx(0) {
   _boards[_current_board_idx] = std::move(board);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <string>
 #include "board.h"
 
 namespace game_of_life {
@@ -27,6 +28,11 @@ public:
 };
 
 
+/// @brief Read board from the file at specified path.
+/// Throws std::runtime_error if the path does not point to a readable file or its content can not be decoded.
+GameBoard loadGameBoardFromFile(const std::string& path, const CellEncoding& encoding = CellEncoding());
+
+
 /// @brief Class summarizing rules of the game of life.
 class GameRules {
   size_t _min_neighbors_to_survive = 2;
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace game_of_life {
+
+/// @brief Split range [begin, end) into contiguous chunks and process them on multiple threads.
+/// The calling thread processes the first chunk, as well as all the chunks for which a thread could not be created.
+/// No extra threads are spawned if the range is shorter than 2 * min_chunk_size.
+/// All the threads are joined before returning. If processing of any chunk throws, the first exception (in chunk order) is rethrown.
+/// @tparam ChunkProcessor callable with signature "void ChunkProcessor(size_t chunk_begin, size_t chunk_end)"
+/// @param max_threads maximal number of threads to use including the calling one, 0 stands for the number of hardware threads
+template<class ChunkProcessor>
+void parallelFor(size_t begin, size_t end, size_t min_chunk_size, ChunkProcessor chunk_processor, size_t max_threads = 0) {
+  if (end <= begin) return;
+  size_t count = end - begin;
+  if (max_threads == 0) max_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  size_t num_chunks = std::min(max_threads, std::max<size_t>(count / std::max<size_t>(min_chunk_size, 1), 1));
+  size_t chunk_size = (count + num_chunks - 1) / num_chunks;
+
+  std::vector<std::exception_ptr> errors(num_chunks);
+  std::vector<std::thread> threads;
+  threads.reserve(num_chunks - 1);
+  size_t chunk_begin = begin + chunk_size;
+  try {
+    for (; chunk_begin < end; chunk_begin += chunk_size) {
+      size_t chunk_end = std::min(chunk_begin + chunk_size, end);
+      auto& error = errors[threads.size() + 1];
+      threads.emplace_back([&chunk_processor, &error, chunk_begin, chunk_end] () {
+        try {
+          chunk_processor(chunk_begin, chunk_end);
+        } catch (...) {
+          error = std::current_exception();
+        }
+      });
+    }
+  } catch (...) {
+    // failed to create a thread: remaining chunks starting from chunk_begin are processed on the calling thread
+  }
+
+  try {
+    chunk_processor(begin, std::min(begin + chunk_size, end));
+    for (; chunk_begin < end; chunk_begin += chunk_size) {
+      chunk_processor(chunk_begin, std::min(chunk_begin + chunk_size, end));
+    }
+  } catch (...) {
+    errors[0] = std::current_exception();
+  }
+  for (auto& thread : threads) thread.join();
+  for (auto& error : errors) {
+    if (error) std::rethrow_exception(error);
+  }
+}
+
+}
@@ -0,0 +1,118 @@
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include "server.h"
+
+namespace game_of_life {
+
+Server::Server(CellEncoding encoding /*= CellEncoding()*/, GameRules rules /*= GameRules()*/)
+  :_encoding(std::move(encoding)), _rules(std::move(rules)) {
+}
+
+
+Server::Game& Server::getGame(const std::string& name) {
+  auto it = _games.find(name);
+  if (it == _games.end()) {
+    throw std::runtime_error("Server::getGame: unknown board: " + name);
+  }
+  return it->second;
+}
+
+
+namespace {
+
+std::string readArgument(std::istream& args, const std::string& description) {
+  std::string arg;
+  if (!(args >> arg)) throw std::runtime_error("Server::execute: " + description + " is missing");
+  return arg;
+}
+
+
+void checkNoMoreArguments(std::istream& args) {
+  std::string arg;
+  if (args >> arg) throw std::runtime_error("Server::execute: unexpected argument: " + arg);
+}
+
+}
+
+
+std::string Server::execute(const std::string& command) {
+  std::istringstream args(command);
+  std::string action;
+  args >> action;
+  try {
+    if (action == "load") {
+      auto name = readArgument(args, "board name");
+      auto path = readArgument(args, "input file path");
+      checkNoMoreArguments(args);
+      auto board = loadGameBoardFromFile(path, _encoding);
+      std::string response = "ok " + std::to_string(board.length()) + " " + std::to_string(board.height());
+      _games.insert_or_assign(name, Game{Engine(std::move(board), _rules), 0});
+      return response;
+    } else if (action == "step") {
+      auto& game = getGame(readArgument(args, "board name"));
+      size_t iterations = 1;
+      std::string iterations_arg;
+      if (args >> iterations_arg) {
+        checkNoMoreArguments(args);
+        bool is_valid = iterations_arg.find_first_not_of("0123456789") == std::string::npos;
+        if (is_valid) {
+          try {
+            iterations = std::stoull(iterations_arg);
+          } catch (const std::out_of_range&) {
+            is_valid = false;
+          }
+        }
+        if (!is_valid) throw std::runtime_error("Server::execute: invalid number of iterations: " + iterations_arg);
+      }
+      for (size_t it = 0; it < iterations; it++) {
+        game.engine.next();
+      }
+      game.generation += iterations;
+      return "ok " + std::to_string(game.generation);
+    } else if (action == "query") {
+      auto& game = getGame(readArgument(args, "board name"));
+      checkNoMoreArguments(args);
+      auto rect = game.engine.board().getOccupiedCellsBoundingRectangle();
+      return "ok " + std::to_string(game.generation) + " " + std::to_string(rect.left) + " " + std::to_string(rect.top)
+        + " " + std::to_string(rect.right) + " " + std::to_string(rect.bottom);
+    } else if (action == "save") {
+      auto& game = getGame(readArgument(args, "board name"));
+      auto path = readArgument(args, "output file path");
+      checkNoMoreArguments(args);
+      std::ofstream output_file(path, std::ios::out | std::ios::binary);
+      if (!output_file) throw std::runtime_error(path + " can not be opened for writing");
+      auto encode = [this] (CellState c) { return _encoding.encode(c); };
+      const auto& board = game.engine.board();
+      board.save(output_file, board.getOccupiedCellsBoundingRectangle(), encode);
+      output_file.close();
+      if (!output_file) throw std::runtime_error("failed to write " + path);
+      return "ok";
+    } else if (action == "drop") {
+      auto name = readArgument(args, "board name");
+      checkNoMoreArguments(args);
+      if (_games.erase(name) == 0) throw std::runtime_error("Server::execute: unknown board: " + name);
+      return "ok";
+    } else {
+      throw std::runtime_error("Server::execute: unsupported command: " + action);
+    }
+  } catch (const std::exception& e) {
+    return std::string("error ") + e.what();
+  }
+}
+
+
+void Server::run(std::istream& is, std::ostream& os) {
+  std::string command;
+  while (std::getline(is, command)) {
+    if (!command.empty() && command.back() == '\r') command.pop_back();
+    std::string action;
+    std::istringstream(command) >> action;
+    if (action.empty()) continue;
+    if (action == "quit") break;
+    os << execute(command) << '\n' << std::flush;
+  }
+}
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <istream>
+#include <ostream>
+#include <unordered_map>
+#include "engine.h"
+
+namespace game_of_life {
+
+/// @brief Class keeping named game engines resident between requests.
+/// Supported commands (one per line, arguments separated by whitespace):
+///   load <name> <path>        - load board from file into engine <name>, replacing existing one. Response: "ok <length> <height>"
+///   step <name> [<iterations>] - advance engine <name> by specified number of iterations (1 by default). Response: "ok <generation>"
+///   query <name>              - get living cells bounding rectangle of engine <name>. Response: "ok <generation> <left> <top> <right> <bottom>"
+///   save <name> <path>        - write living cells area of engine <name> to file. Response: "ok"
+///   drop <name>               - remove engine <name>. Response: "ok"
+///   quit                      - stop processing commands
+/// Failed commands produce "error <description>" response.
+class Server {
+private:
+  struct Game {
+    Engine engine;
+    size_t generation;
+  };
+  std::unordered_map<std::string, Game> _games;
+  CellEncoding _encoding;
+  GameRules _rules;
+
+  Game& getGame(const std::string& name);
+public:
+  /// @brief Construct from cell encoding used by load and save commands and rules used by all engines.
+  Server(CellEncoding encoding = CellEncoding(), GameRules rules = GameRules());
+  /// @brief Execute a single command.
+  /// @return Response line without trailing line separator.
+  std::string execute(const std::string& command);
+  /// @brief Execute commands read line by line from is and write responses to os until "quit" command or end of stream.
+  void run(std::istream& is, std::ostream& os);
+};
+
+}
@@ -2,13 +2,17 @@
 #include <boost/program_options.hpp>
 #include <filesystem>
 #include <fstream>
+#include <limits>
 #include "core/engine.h"
+#include "core/server.h"
 
 
 struct Options {
   std::string input_filename = "";
   size_t num_iterations = 0;
   bool all = false;
+  size_t density_block_size = 0;
+  bool serve = false;
 };
 
 
@@ -20,16 +24,27 @@ std::tuple<Options, bool> processOptions(int argc, char **argv) {
     ("help", "see help message")
     ("input", boost::program_options::value(&opts.input_filename), "A string representing the input file path. This parameter is mandatory.")
     ("iterations", boost::program_options::value(&opts.num_iterations), "A positivie integer representing the number of iterations to apply the rules.")
-    ("all", "Print all the iterations. This parameter is optional. If absent, only the last step is printed.");
+    ("all", "Print all the iterations. This parameter is optional. If absent, only the last step is printed.")
+    ("density-block", boost::program_options::value(&opts.density_block_size),
+      "A positive integer representing the block size. This parameter is optional. If present, a grayscale PGM density map "
+      "with one pixel per block of cells is printed instead of the board.")
+    ("serve", "Keep boards resident and process load/step/query/save/drop commands read from standard input. "
+      "If present, input and iterations parameters are ignored.");
 
   boost::program_options::variables_map vm;
   boost::program_options::store(boost::program_options::command_line_parser(argc, argv).options(options_description).run(), vm);
   boost::program_options::notify(vm);
 
+  opts.serve = vm.count("serve");
   if (vm.count("help")) {
     std::cout << options_description;
+  } else if (opts.serve) {
+    is_ok = true;
   } else if ( !vm.count("input") || !vm.count("iterations")) {
     std::cerr << options_description;
+  } else if (vm.count("density-block")
+    && (opts.density_block_size == 0 || opts.density_block_size > static_cast<size_t>(std::numeric_limits<int>::max()))) {
+    std::cerr << "density-block should be a positive integer not exceeding " << std::numeric_limits<int>::max() << std::endl;
   } else {
     is_ok = true;
   }
@@ -38,19 +53,6 @@ std::tuple<Options, bool> processOptions(int argc, char **argv) {
 };
 
 
-game_of_life::GameBoard loadBoardFromFile(const std::string& input_filename) {
-  game_of_life::GameBoard board;
-  if (!std::filesystem::exists(input_filename) || std::filesystem::is_directory(input_filename)) {
-    throw std::runtime_error(input_filename + " is not a valid path to an input file");
-  }
-  std::ifstream input_file(input_filename, std::ios::in | std::ios::binary);
-  game_of_life::CellEncoding encoding;
-  auto decode = [&encoding] (char c) { return encoding.decode(c); };
-  board.load(input_file, decode);
-  return board;
-}
-
-
 void runGame(game_of_life::GameBoard board, const Options& opts) {
   game_of_life::Engine game_engine(std::move(board), game_of_life::GameRules());
 
@@ -64,10 +66,16 @@ void runGame(game_of_life::GameBoard board, const Options& opts) {
   for (size_t it = 1; it <= opts.num_iterations; it++) {
     game_engine.next();
     if (it == opts.num_iterations || opts.all) {
-      std::string output_filename = parent_path / (stem + "_" + std::to_string(it) + extension);
-      std::ofstream output_file(output_filename, std::ios::out | std::ios::binary);
       auto alive_cell_bounding_rect = game_engine.board().getOccupiedCellsBoundingRectangle();
-      game_engine.board().save(output_file, alive_cell_bounding_rect, encode);
+      if (opts.density_block_size > 0) {
+        std::string output_filename = parent_path / (stem + "_" + std::to_string(it) + ".pgm");
+        std::ofstream output_file(output_filename, std::ios::out | std::ios::binary);
+        game_engine.board().saveDensityMap(output_file, alive_cell_bounding_rect, opts.density_block_size);
+      } else {
+        std::string output_filename = parent_path / (stem + "_" + std::to_string(it) + extension);
+        std::ofstream output_file(output_filename, std::ios::out | std::ios::binary);
+        game_engine.board().save(output_file, alive_cell_bounding_rect, encode);
+      }
     }
   }
 }
@@ -77,9 +85,16 @@ int main (int argc, char **argv) {
   auto [opts, is_ok] = processOptions(argc, argv);
   if (!is_ok) return 1;
 
+  if (opts.serve) {
+    std::ios::sync_with_stdio(false);
+    game_of_life::Server server;
+    server.run(std::cin, std::cout);
+    return 0;
+  }
+
   game_of_life::GameBoard board;
   try {
-    board = loadBoardFromFile(opts.input_filename);
+    board = game_of_life::loadGameBoardFromFile(opts.input_filename);
   } catch (const std::exception& e) {
     std::cerr << "Failed to load data from input file: " << e.what() << std::endl;
     return 1;
@@ -2,7 +2,12 @@
 #include <string>
 #include <gtest/gtest.h>
 #include "../src/core/engine.h"
+#include "../src/core/server.h"
 #include <sstream>
+#include <fstream>
+#include <filesystem>
+#include <limits>
+#include <thread>
 
 using namespace game_of_life;
 
@@ -192,6 +197,128 @@ TEST(GameBoard, save) {
 }
 
 
+TEST(GameBoard, save_matches_cell_by_cell_encoding) {
+  CellEncoding encoding('#', ' ');
+  auto encode = [&encoding](CellState cell) { return encoding.encode(cell); };
+  auto saveCellByCell = [&encode](const GameBoard& board, const Rectangle& rect, char row_separator) {
+    std::string s;
+    for (size_t y = rect.top; y < rect.bottom; y++) {
+      for (size_t x = rect.left; x < rect.right; x++) s.push_back(encode(board.getCell(x, y)));
+      s.push_back(row_separator);
+    }
+    return s;
+  };
+
+  // large enough to be split across threads
+  GameBoard board(1000, 700);
+  for (size_t y = 0; y < board.height(); y += 3) {
+    for (size_t x = y % 7; x < board.length(); x += 5) board.setCell(x, y, CellState::ALIVE);
+  }
+  std::vector<Rectangle> rects = {
+    board.getOccupiedCellsBoundingRectangle(), {0, 0, 1000, 700}, {13, 7, 800, 650}, {990, 690, 1010, 720}, {5, 5, 5, 9}
+  };
+  for (const auto& rect : rects) {
+    std::stringstream out;
+    board.save(out, rect, encode, '|');
+    ASSERT_EQ(out.str(), saveCellByCell(board, rect, '|'));
+  }
+
+  // output larger than a single write batch
+  GameBoard large_board(3000, 3000);
+  for (size_t y = 0; y < large_board.height(); y += 11) {
+    for (size_t x = y % 13; x < large_board.length(); x += 17) large_board.setCell(x, y, CellState::ALIVE);
+  }
+  Rectangle large_rect = {0, 0, 3000, 3000};
+  std::stringstream large_out;
+  large_board.save(large_out, large_rect, encode);
+  ASSERT_EQ(large_out.str(), saveCellByCell(large_board, large_rect, '\n'));
+}
+
+
+TEST(GameBoard, save_propagates_encoder_exception) {
+  GameBoard board(1000, 700);
+  board.setCell(500, 600, CellState::ALIVE);
+  auto encode = [](CellState cell) {
+    if (cell == CellState::ALIVE) throw std::runtime_error("can not encode");
+    return '_';
+  };
+  std::stringstream out;
+  ASSERT_THROW(board.save(out, {0, 0, 1000, 700}, encode), std::runtime_error);
+}
+
+
+TEST(GameBoard, getOccupiedCellsCountByBlock) {
+  GameBoard board;
+  std::stringstream ss = getStream(BOARD_ALIVE);
+  board.load(ss, DECODE);
+
+  ASSERT_EQ(board.getOccupiedCellsCountByBlock({0, 0, 4, 3}, 1), std::vector<size_t>({1, 1, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0}));
+  ASSERT_EQ(board.getOccupiedCellsCountByBlock({0, 0, 4, 3}, 2), std::vector<size_t>({3, 1, 0, 0}));
+  ASSERT_EQ(board.getOccupiedCellsCountByBlock({1, 0, 4, 3}, 2), std::vector<size_t>({3, 0, 0, 0}));
+  ASSERT_EQ(board.getOccupiedCellsCountByBlock({0, 0, 4, 3}, 10), std::vector<size_t>({4}));
+  ASSERT_EQ(board.getOccupiedCellsCountByBlock({0, 0, 0, 0}, 2), std::vector<size_t>());
+  // blocks larger than the area
+  ASSERT_EQ(board.getOccupiedCellsCountByBlock({0, 0, 4, 3}, std::numeric_limits<size_t>::max()), std::vector<size_t>({4}));
+  ASSERT_EQ(board.getOccupiedCellsCountByBlock({1, 1, 4, 3}, size_t(1) << 63), std::vector<size_t>({1}));
+}
+
+
+TEST(GameBoard, saveDensityMap) {
+  GameBoard board;
+  std::stringstream ss = getStream(BOARD_ALIVE);
+  board.load(ss, DECODE);
+
+  std::stringstream out;
+  board.saveDensityMap(out, {0, 0, 4, 3}, 2);
+  ASSERT_EQ(out.str(), std::string("P5\n2 2\n255\n\xbf\x3f\x00\x00", 15));
+
+  std::stringstream out_large_block;
+  board.saveDensityMap(out_large_block, {0, 0, 4, 3}, std::numeric_limits<size_t>::max());
+  ASSERT_EQ(out_large_block.str(), "P5\n1 1\n255\n\x55");
+
+  std::stringstream out_empty;
+  board.saveDensityMap(out_empty, {0, 0, 0, 0}, 2);
+  ASSERT_EQ(out_empty.str(), std::string("P5\n1 1\n255\n\0", 12));
+}
+
+
+TEST(Parallel, parallelFor) {
+  // force several threads regardless of the number of hardware threads
+  const size_t max_threads = 4;
+  std::vector<size_t> processed(1000, 0);
+  std::vector<std::thread::id> thread_ids(1000);
+  parallelFor(0, processed.size(), 1, [&] (size_t chunk_begin, size_t chunk_end) {
+    for (size_t i = chunk_begin; i < chunk_end; i++) {
+      processed[i]++;
+      thread_ids[i] = std::this_thread::get_id();
+    }
+  }, max_threads);
+  ASSERT_EQ(processed, std::vector<size_t>(1000, 1));
+  ASSERT_EQ(thread_ids.front(), std::this_thread::get_id());
+  ASSERT_NE(thread_ids.back(), std::this_thread::get_id());
+
+  // exceptions thrown by any chunk are propagated to the caller
+  ASSERT_THROW(
+    parallelFor(0, 1000, 1, [] (size_t /*chunk_begin*/, size_t chunk_end) {
+      if (chunk_end == 1000) throw std::runtime_error("last chunk");
+    }, max_threads),
+    std::runtime_error
+  );
+  ASSERT_THROW(
+    parallelFor(0, 1000, 1, [] (size_t chunk_begin, size_t /*chunk_end*/) {
+      if (chunk_begin == 0) throw std::runtime_error("first chunk");
+    }, max_threads),
+    std::runtime_error
+  );
+  ASSERT_THROW(
+    parallelFor(0, 1000, 1, [] (size_t /*chunk_begin*/, size_t /*chunk_end*/) {
+      throw std::runtime_error("all chunks");
+    }, max_threads),
+    std::runtime_error
+  );
+}
+
+
 TEST(GameBoard, reset) {
   GameBoard board;
   std::stringstream ss = getStream(BOARD_ALIVE);
@@ -307,6 +434,76 @@ TEST(Engine, next) {
 
 
 
+TEST(Server, execute) {
+  auto input_path = std::filesystem::temp_directory_path() / "game_of_life_test_server_input.txt";
+  auto output_path = std::filesystem::temp_directory_path() / "game_of_life_test_server_output.txt";
+  {
+    std::ofstream input_file(input_path, std::ios::out | std::ios::binary);
+    input_file << BOARD_ALIVE;
+  }
+
+  Server server;
+  ASSERT_EQ(server.execute("load b " + input_path.string()), "ok 4 3");
+  ASSERT_EQ(server.execute("query b"), "ok 0 0 0 3 2");
+  ASSERT_EQ(server.execute("step b"), "ok 1");
+  ASSERT_EQ(server.execute("step b 3"), "ok 4");
+  ASSERT_EQ(server.execute("query b"), "ok 4 1 2 4 5");
+  ASSERT_EQ(server.execute("save b " + output_path.string()), "ok");
+  {
+    std::ifstream output_file(output_path, std::ios::in | std::ios::binary);
+    std::stringstream ss;
+    ss << output_file.rdbuf();
+    ASSERT_EQ(ss.str(), "***\n*_*\n***\n");
+  }
+  ASSERT_EQ(server.execute("drop b"), "ok");
+
+  ASSERT_EQ(server.execute("query b").rfind("error ", 0), 0);
+  ASSERT_EQ(server.execute("step").rfind("error ", 0), 0);
+  ASSERT_EQ(server.execute("load c").rfind("error ", 0), 0);
+  ASSERT_EQ(server.execute("load c " + input_path.string()), "ok 4 3");
+  ASSERT_EQ(server.execute("step c -1").rfind("error ", 0), 0);
+  ASSERT_EQ(server.execute("unknown c").rfind("error ", 0), 0);
+  ASSERT_EQ(server.execute("unknown").rfind("error Server::execute: unsupported command", 0), 0);
+  ASSERT_EQ(server.execute("step c 99999999999999999999"), "error Server::execute: invalid number of iterations: 99999999999999999999");
+  ASSERT_EQ(server.execute("step c 2 junk"), "error Server::execute: unexpected argument: junk");
+  ASSERT_EQ(server.execute("load c " + input_path.string() + " extra"), "error Server::execute: unexpected argument: extra");
+  ASSERT_EQ(server.execute("query c"), "ok 0 0 0 3 2");
+  ASSERT_EQ(server.execute("load d " + std::filesystem::temp_directory_path().string()).rfind("error ", 0), 0);
+  ASSERT_EQ(server.execute("query d").rfind("error ", 0), 0);
+  ASSERT_EQ(server.execute("save c " + std::filesystem::temp_directory_path().string()).rfind("error ", 0), 0);
+  ASSERT_EQ(server.execute("drop c"), "ok");
+  ASSERT_EQ(server.execute("drop c").rfind("error ", 0), 0);
+
+  // malformed board content
+  {
+    std::ofstream input_file(input_path, std::ios::out | std::ios::binary);
+    input_file << BOARD_ROWS_BAD_CHAR;
+  }
+  ASSERT_EQ(server.execute("load e " + input_path.string()), "error CellState::decode: unsupported character: X");
+  ASSERT_EQ(server.execute("query e").rfind("error ", 0), 0);
+
+  std::filesystem::remove(input_path);
+  std::filesystem::remove(output_path);
+}
+
+
+TEST(Server, run) {
+  Server server;
+  std::stringstream in = getStream("query a\n\n \t\n quit\t\nquery a\n");
+  std::stringstream out;
+  server.run(in, out);
+  ASSERT_EQ(out.str(), "error Server::getGame: unknown board: a\n");
+
+  // quit is recognized regardless of surrounding whitespace
+  for (const std::string quit : {"quit", " quit", "quit ", "quit\t", "quit\r"}) {
+    std::stringstream in_quit = getStream(quit + "\nquery a\n");
+    std::stringstream out_quit;
+    server.run(in_quit, out_quit);
+    ASSERT_EQ(out_quit.str(), "");
+  }
+}
+
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();